@@ -0,0 +1,34 @@
+# Find the zstd compression library
+#
+# Variables defined by this module:
+#
+# ZSTD_FOUND        - True if zstd was found
+# ZSTD_INCLUDE_DIRS - Path to the zstd.h header
+# ZSTD_LIBRARIES    - Libraries to link against
+
+find_package(PkgConfig)
+if(PKG_CONFIG_FOUND)
+  pkg_check_modules(PC_ZSTD QUIET libzstd)
+endif()
+
+find_path(
+  ZSTD_INCLUDE_DIRS
+  NAMES zstd.h
+  HINTS ${PC_ZSTD_INCLUDE_DIRS}
+  PATHS /usr/local/include
+        /usr/include
+)
+
+find_library(
+  ZSTD_LIBRARIES
+  NAMES zstd
+  HINTS ${PC_ZSTD_LIBRARY_DIRS}
+  PATHS /usr/local/lib
+        /usr/local/lib64
+        /usr/lib
+        /usr/lib64
+)
+
+include(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(ZSTD DEFAULT_MSG ZSTD_LIBRARIES ZSTD_INCLUDE_DIRS)
+mark_as_advanced(ZSTD_LIBRARIES ZSTD_INCLUDE_DIRS)
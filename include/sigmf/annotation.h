@@ -679,6 +679,8 @@
 #define INCLUDED_SIGMF_ANNOTATION_H
 
 #include <sigmf/api.h>
+#include <sigmf/interned_string.h>
+#include <string>
 
 namespace gr {
   namespace sigmf {
@@ -718,6 +720,16 @@ namespace gr {
 	void
 	set_generator (const std::string& generator);
 
+	/*!
+	 * \brief core:generator as an interned handle, for comparisons
+	 * by pointer.
+	 */
+	const interned_string&
+	get_interned_generator () const;
+
+	void
+	set_generator (const interned_string& generator);
+
 	size_t
 	get_sample_count () const;
 
@@ -734,7 +746,7 @@ namespace gr {
 	size_t d_sample_start;
 	size_t d_sample_count;
 
-	std::string d_generator;
+	interned_string d_generator;
 	std::string d_comment;
 
 	double d_freq_lower_edge;
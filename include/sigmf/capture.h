@@ -679,6 +679,7 @@
 #define INCLUDED_SIGMF_CAPTURE_H
 
 #include <sigmf/api.h>
+#include <string>
 
 namespace gr {
   namespace sigmf {
@@ -679,6 +679,8 @@
 #define INCLUDED_SIGMF_GLOBAL_H
 
 #include <sigmf/api.h>
+#include <sigmf/interned_string.h>
+#include <string>
 
 namespace gr {
   namespace sigmf {
@@ -686,6 +688,9 @@ namespace gr {
     /*!
      * \brief Class that represents the global object of the SigMF
      * specification.
+     *
+     * core:author, core:license and core:hw repeat across the
+     * recordings of a catalog and are kept as interned strings.
      */
     class SIGMF_API global
     {
@@ -699,6 +704,12 @@ namespace gr {
 	void
 	set_author (const std::string& author);
 
+	const interned_string&
+	get_interned_author () const;
+
+	void
+	set_author (const interned_string& author);
+
 	const std::string&
 	get_datatype () const;
 
@@ -716,12 +727,24 @@ namespace gr {
 	void
 	set_hw (const std::string& hw);
 
+	const interned_string&
+	get_interned_hw () const;
+
+	void
+	set_hw (const interned_string& hw);
+
 	const std::string&
 	get_license () const;
 
 	void
 	set_license (const std::string& license);
 
+	const interned_string&
+	get_interned_license () const;
+
+	void
+	set_license (const interned_string& license);
+
 	size_t
 	get_offset () const;
 
@@ -752,9 +775,9 @@ namespace gr {
 	std::string d_version;
 	std::string d_sha512;
 	std::string d_description;
-	std::string d_author;
-	std::string d_license;
-	std::string d_hw;
+	interned_string d_author;
+	interned_string d_license;
+	interned_string d_hw;
 
 	double d_sample_rate;
 
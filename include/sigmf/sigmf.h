@@ -679,15 +679,22 @@
 #define INCLUDED_SIGMF_SIGMF_H
 
 #include <sigmf/api.h>
+#include <sigmf/arena.h>
+#include <sigmf/metadata_handler.h>
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/document.h>
 #include <rapidjson/schema.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/filereadstream.h>
+#include <rapidjson/filewritestream.h>
 #include <rapidjson/error/en.h>
+#include <vector>
 
 #define RAPIDJSON_BUFFER_SIZE	4096
 
+/* Version of the SigMF specification written to core:version */
+#define SIGMF_VERSION		"0.0.1"
+
 namespace gr {
   namespace sigmf {
 
@@ -698,12 +705,90 @@ namespace gr {
     class SIGMF_API sigmf
     {
       public:
-	sigmf (FILE* fp, std::string metadata_filename);
+	/*!
+	 * \brief Selects how the metadata file is parsed.
+	 *
+	 * PARSE_DOM loads the whole file into a rapidjson::Document before
+	 * any object is reported. PARSE_SAX reports every object as soon as
+	 * it has been read, using a fixed amount of memory regardless of
+	 * the number of captures and annotations.
+	 */
+	enum parse_mode_t
+	{
+	  PARSE_DOM = 0,
+	  PARSE_SAX
+	};
+
+	/*!
+	 * \brief Selects how much parse() checks the file.
+	 *
+	 * VALIDATE_NONE trusts the file and only reports what it finds.
+	 * VALIDATE_STRUCTURE checks that the required core fields are
+	 * present with the right type: core:datatype and core:version in
+	 * the global object, core:sample_start in captures and
+	 * annotations, core:sample_count in annotations. It costs next to
+	 * nothing. VALIDATE_SCHEMA validates the file against the SigMF
+	 * schema, which also rejects core: fields it does not define;
+	 * with PARSE_SAX this happens in the same pass as the parse.
+	 */
+	enum validation_t
+	{
+	  VALIDATE_NONE = 0,
+	  VALIDATE_STRUCTURE,
+	  VALIDATE_SCHEMA
+	};
+
+	sigmf (FILE* fp, std::string metadata_filename,
+	       validation_t validation = VALIDATE_NONE);
 	~sigmf ();
 
+	/*!
+	 * \brief Parses the metadata file and passes the global, capture
+	 * and annotation objects to \p handler.
+	 *
+	 * In PARSE_SAX mode the objects are reported in file order. In
+	 * PARSE_DOM mode the global object is reported first, followed by
+	 * the captures and then the annotations.
+	 *
+	 * \throws std::runtime_error if the file is not valid JSON, or
+	 * fails the validation selected when this object was created.
+	 */
+	void
+	parse (metadata_handler& handler, parse_mode_t mode = PARSE_SAX);
+
+	/*!
+	 * \brief Validates the metadata file against the SigMF schema.
+	 *
+	 * The schema is embedded in the library and compiled once per
+	 * process, and each thread reuses its validator, so validating
+	 * many files only costs the pass over each file.
+	 *
+	 * \throws std::runtime_error if the file is not valid JSON or does
+	 * not match the schema.
+	 */
+	void
+	validate ();
+
+	/*!
+	 * \brief Serializes a complete metadata document to the file.
+	 *
+	 * Fields that hold their unset value (empty strings, -1) are
+	 * omitted.
+	 */
+	void
+	write (const global& g, const std::vector<capture>& captures,
+	       const std::vector<annotation>& annotations);
+
+	const std::string&
+	get_metadata_filename () const;
+
+	const std::string&
+	get_dataset_filename () const;
+
       private:
 
 	FILE* d_fp;
+	validation_t d_validation;
 
 	char d_read_buf[RAPIDJSON_BUFFER_SIZE];
 	char d_write_buf[RAPIDJSON_BUFFER_SIZE];
@@ -712,7 +797,10 @@ namespace gr {
 	std::string d_dataset_filename;
 
 	rapidjson::Document *d_doc;
-	rapidjson::SchemaDocument *d_sd;
+	/* Holds every value and string of d_doc, freed at once */
+	arena *d_arena;
+	/* Shared schema and validator of the thread, not owned */
+	const rapidjson::SchemaDocument *d_sd;
 	rapidjson::SchemaValidator *d_validator;
 
 	rapidjson::FileReadStream *d_frs;
@@ -732,6 +820,12 @@ namespace gr {
 	void
 	set_filenames(const std::string& metadata_filename);
 
+	void
+	parse_sax (metadata_handler& handler);
+
+	void
+	parse_dom (metadata_handler& handler);
+
     };
 
   } // namespace sigmf
@@ -737,11 +737,23 @@ namespace gr {
     const std::string&
     annotation::get_generator () const
     {
-      return d_generator;
+      return d_generator.str ();
     }
 
     void
     annotation::set_generator (const std::string& generator)
+    {
+      d_generator = interned_string (generator);
+    }
+
+    const interned_string&
+    annotation::get_interned_generator () const
+    {
+      return d_generator;
+    }
+
+    void
+    annotation::set_generator (const interned_string& generator)
     {
       d_generator = generator;
     }
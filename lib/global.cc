@@ -700,11 +700,23 @@ namespace gr {
     const std::string&
     gr::sigmf::global::get_author () const
     {
-      return d_author;
+      return d_author.str ();
     }
 
     void
     gr::sigmf::global::set_author (const std::string& author)
+    {
+      d_author = interned_string (author);
+    }
+
+    const interned_string&
+    gr::sigmf::global::get_interned_author () const
+    {
+      return d_author;
+    }
+
+    void
+    gr::sigmf::global::set_author (const interned_string& author)
     {
       d_author = author;
     }
@@ -737,11 +749,23 @@ namespace gr {
     const std::string&
     gr::sigmf::global::get_hw () const
     {
-      return d_hw;
+      return d_hw.str ();
     }
 
     void
     gr::sigmf::global::set_hw (const std::string& hw)
+    {
+      d_hw = interned_string (hw);
+    }
+
+    const interned_string&
+    gr::sigmf::global::get_interned_hw () const
+    {
+      return d_hw;
+    }
+
+    void
+    gr::sigmf::global::set_hw (const interned_string& hw)
     {
       d_hw = hw;
     }
@@ -749,11 +773,23 @@ namespace gr {
     const std::string&
     gr::sigmf::global::get_license () const
     {
-      return d_license;
+      return d_license.str ();
     }
 
     void
     gr::sigmf::global::set_license (const std::string& license)
+    {
+      d_license = interned_string (license);
+    }
+
+    const interned_string&
+    gr::sigmf::global::get_interned_license () const
+    {
+      return d_license;
+    }
+
+    void
+    gr::sigmf::global::set_license (const interned_string& license)
     {
       d_license = license;
     }
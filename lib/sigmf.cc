@@ -681,18 +681,379 @@
 
 #include <gnuradio/io_signature.h>
 #include <sigmf/sigmf.h>
+#include "json_writer.h"
+#include "sax_handler.h"
+#include "schema_cache.h"
+
+#include <rapidjson/prettywriter.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
 
 namespace gr {
   namespace sigmf {
 
-    sigmf::sigmf (FILE* fp, std::string metadata_filename)
+    static void
+    throw_parse_error (const std::string& filename,
+		       rapidjson::ParseErrorCode code, size_t offset)
+    {
+      std::ostringstream msg;
+      msg << "sigmf: " << filename << ": "
+	  << rapidjson::GetParseError_En (code)
+	  << " (offset " << offset << ")";
+      throw std::runtime_error (msg.str ());
+    }
+
+    template<typename Validator>
+    static void
+    throw_schema_error (const std::string& filename,
+			const Validator& validator)
+    {
+      rapidjson::StringBuffer document;
+      rapidjson::StringBuffer schema;
+      validator.GetInvalidDocumentPointer ().StringifyUriFragment (document);
+      validator.GetInvalidSchemaPointer ().StringifyUriFragment (schema);
+
+      std::ostringstream msg;
+      msg << "sigmf: " << filename << ": " << document.GetString ()
+	  << " does not match " << schema.GetString () << " ("
+	  << validator.GetInvalidSchemaKeyword () << ")";
+      throw std::runtime_error (msg.str ());
+    }
+
+    static bool
+    has_uint64 (const rapidjson::Value& obj, const char* key)
+    {
+      rapidjson::Value::ConstMemberIterator itr = obj.FindMember (key);
+      return itr != obj.MemberEnd () && itr->value.IsUint64 ();
+    }
+
+    static bool
+    has_string (const rapidjson::Value& obj, const char* key)
+    {
+      rapidjson::Value::ConstMemberIterator itr = obj.FindMember (key);
+      return itr != obj.MemberEnd () && itr->value.IsString ();
+    }
+
+    /*!
+     * \brief The structure check of sax_handler, on a parsed document.
+     *
+     * \return what is wrong, empty if nothing is
+     */
+    static std::string
+    check_structure (const rapidjson::Value& doc)
+    {
+      rapidjson::Value::ConstMemberIterator itr;
+      rapidjson::Value::ConstValueIterator v;
+
+      itr = doc.FindMember ("global");
+      if (itr == doc.MemberEnd () || !itr->value.IsObject ()) {
+	return "no global object";
+      }
+      if (!has_string (itr->value, "core:datatype")) {
+	return "global: missing or invalid core:datatype";
+      }
+      if (!has_string (itr->value, "core:version")) {
+	return "global: missing or invalid core:version";
+      }
+
+      itr = doc.FindMember ("captures");
+      if (itr != doc.MemberEnd () && itr->value.IsArray ()) {
+	for (v = itr->value.Begin (); v != itr->value.End (); ++v) {
+	  if (v->IsObject () && !has_uint64 (*v, "core:sample_start")) {
+	    return "capture: missing or invalid core:sample_start";
+	  }
+	}
+      }
+
+      itr = doc.FindMember ("annotations");
+      if (itr != doc.MemberEnd () && itr->value.IsArray ()) {
+	for (v = itr->value.Begin (); v != itr->value.End (); ++v) {
+	  if (!v->IsObject ()) {
+	    continue;
+	  }
+	  if (!has_uint64 (*v, "core:sample_start")) {
+	    return "annotation: missing or invalid core:sample_start";
+	  }
+	  if (!has_uint64 (*v, "core:sample_count")) {
+	    return "annotation: missing or invalid core:sample_count";
+	  }
+	}
+      }
+      return "";
+    }
+
+    static bool
+    dom_string (const rapidjson::Value& obj, const char* key,
+		std::string& out)
+    {
+      rapidjson::Value::ConstMemberIterator itr = obj.FindMember (key);
+      if (itr == obj.MemberEnd () || !itr->value.IsString ()) {
+	return false;
+      }
+      out.assign (itr->value.GetString (), itr->value.GetStringLength ());
+      return true;
+    }
+
+    /* Interns straight from the document, without a std::string copy */
+    static bool
+    dom_string (const rapidjson::Value& obj, const char* key,
+		interned_string& out)
+    {
+      rapidjson::Value::ConstMemberIterator itr = obj.FindMember (key);
+      if (itr == obj.MemberEnd () || !itr->value.IsString ()) {
+	return false;
+      }
+      out = interned_string (itr->value.GetString (),
+			     itr->value.GetStringLength ());
+      return true;
+    }
+
+    static bool
+    dom_double (const rapidjson::Value& obj, const char* key, double& out)
+    {
+      rapidjson::Value::ConstMemberIterator itr = obj.FindMember (key);
+      if (itr == obj.MemberEnd () || !itr->value.IsNumber ()) {
+	return false;
+      }
+      out = itr->value.GetDouble ();
+      return true;
+    }
+
+    static bool
+    dom_uint64 (const rapidjson::Value& obj, const char* key,
+		uint64_t& out)
+    {
+      rapidjson::Value::ConstMemberIterator itr = obj.FindMember (key);
+      if (itr == obj.MemberEnd () || !itr->value.IsUint64 ()) {
+	return false;
+      }
+      out = itr->value.GetUint64 ();
+      return true;
+    }
+
+    static global
+    dom_global (const rapidjson::Value& obj)
+    {
+      global g ("", "");
+      std::string s;
+      interned_string is;
+      double d;
+      uint64_t u;
+
+      if (dom_string (obj, "core:datatype", s)) {
+	g.set_datatype (s);
+      }
+      if (dom_string (obj, "core:version", s)) {
+	g.set_version (s);
+      }
+      if (dom_string (obj, "core:sha512", s)) {
+	g.set_sha512 (s);
+      }
+      if (dom_string (obj, "core:description", s)) {
+	g.set_description (s);
+      }
+      if (dom_string (obj, "core:author", is)) {
+	g.set_author (is);
+      }
+      if (dom_string (obj, "core:license", is)) {
+	g.set_license (is);
+      }
+      if (dom_string (obj, "core:hw", is)) {
+	g.set_hw (is);
+      }
+      if (dom_double (obj, "core:sample_rate", d)) {
+	g.set_sample_rate (d);
+      }
+      if (dom_uint64 (obj, "core:offset", u)) {
+	g.set_offset (u);
+      }
+      return g;
+    }
+
+    static capture
+    dom_capture (const rapidjson::Value& obj)
+    {
+      capture c (0);
+      std::string s;
+      double d;
+      uint64_t u;
+
+      if (dom_uint64 (obj, "core:sample_start", u)) {
+	c.set_sample_start (u);
+      }
+      if (dom_double (obj, "core:frequency", d)) {
+	c.set_frequency (d);
+      }
+      if (dom_string (obj, "core:datetime", s)) {
+	c.set_datetime (s);
+      }
+      return c;
+    }
+
+    static annotation
+    dom_annotation (const rapidjson::Value& obj)
+    {
+      annotation a (0, 0);
+      std::string s;
+      interned_string is;
+      double d;
+      uint64_t u;
+
+      if (dom_uint64 (obj, "core:sample_start", u)) {
+	a.set_sample_start (u);
+      }
+      if (dom_uint64 (obj, "core:sample_count", u)) {
+	a.set_sample_count (u);
+      }
+      if (dom_string (obj, "core:generator", is)) {
+	a.set_generator (is);
+      }
+      if (dom_string (obj, "core:comment", s)) {
+	a.set_comment (s);
+      }
+      if (dom_double (obj, "core:freq_lower_edge", d)) {
+	a.set_freq_lower_edge (d);
+      }
+      if (dom_double (obj, "core:freq_upper_edge", d)) {
+	a.set_freq_upper_edge (d);
+      }
+      return a;
+    }
+
+    /*
+     * A DOM takes about twice the size of its JSON text, names and
+     * strings included. A chunk that large holds the whole document.
+     */
+    static size_t
+    dom_chunk (FILE* fp)
+    {
+      struct stat st;
+      if (fstat (fileno (fp), &st) < 0 || st.st_size <= 0) {
+	return 64 * 1024;
+      }
+      return std::max<size_t> (2 * st.st_size, 64 * 1024);
+    }
+
+    sigmf::sigmf (FILE* fp, std::string metadata_filename,
+		  validation_t validation)
     {
       d_fp = fp;
+      d_validation = validation;
+      d_doc = NULL;
+      d_arena = NULL;
+      d_sd = NULL;
+      d_validator = NULL;
+      d_frs = NULL;
       set_filenames(metadata_filename);
     }
 
     sigmf::~sigmf ()
     {
+      delete d_frs;
+      delete d_doc;
+      delete d_arena;
+    }
+
+    void
+    sigmf::parse (metadata_handler& handler, parse_mode_t mode)
+    {
+      if (!d_fp) {
+	throw std::runtime_error ("sigmf: no metadata file to parse");
+      }
+
+      rewind (d_fp);
+      delete d_frs;
+      d_frs = new rapidjson::FileReadStream (d_fp, d_read_buf,
+					      RAPIDJSON_BUFFER_SIZE);
+
+      switch (mode)
+	{
+	case PARSE_SAX:
+	  parse_sax (handler);
+	  break;
+	case PARSE_DOM:
+	  parse_dom (handler);
+	  break;
+	default:
+	  throw std::invalid_argument ("sigmf: invalid parse mode");
+	}
+    }
+
+    void
+    sigmf::validate ()
+    {
+      if (!d_fp) {
+	throw std::runtime_error ("sigmf: no metadata file to validate");
+      }
+
+      /* Both are owned by the cache, the validator by this thread */
+      d_sd = &schema_cache::document ();
+      d_validator = &schema_cache::validator ();
+
+      rewind (d_fp);
+      rapidjson::FileReadStream frs (d_fp, d_read_buf, RAPIDJSON_BUFFER_SIZE);
+      rapidjson::Reader reader;
+      rapidjson::ParseResult res = reader.Parse (frs, *d_validator);
+      if (!d_validator->IsValid ()) {
+	throw_schema_error (d_metadata_filename, *d_validator);
+      }
+      if (res.IsError ()) {
+	throw_parse_error (d_metadata_filename, res.Code (), res.Offset ());
+      }
+    }
+
+    void
+    sigmf::write (const global& g, const std::vector<capture>& captures,
+		  const std::vector<annotation>& annotations)
+    {
+      if (!d_fp) {
+	throw std::runtime_error ("sigmf: no metadata file to write");
+      }
+
+      rapidjson::FileWriteStream os (d_fp, d_write_buf,
+				     RAPIDJSON_BUFFER_SIZE);
+      rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer (os);
+
+      writer.StartObject ();
+      writer.Key ("global");
+      write_global (writer, g);
+
+      writer.Key ("captures");
+      writer.StartArray ();
+      for (size_t i = 0; i < captures.size (); i++) {
+	write_capture (writer, captures[i]);
+      }
+      writer.EndArray ();
+
+      writer.Key ("annotations");
+      writer.StartArray ();
+      for (size_t i = 0; i < annotations.size (); i++) {
+	write_annotation (writer, annotations[i]);
+      }
+      writer.EndArray ();
+      writer.EndObject ();
+
+      os.Flush ();
+      if (fflush (d_fp) != 0) {
+	throw std::runtime_error (
+	    "sigmf: " + d_metadata_filename + ": " + strerror (errno));
+      }
+    }
+
+    const std::string&
+    sigmf::get_metadata_filename () const
+    {
+      return d_metadata_filename;
+    }
+
+    const std::string&
+    sigmf::get_dataset_filename () const
+    {
+      return d_dataset_filename;
     }
 
     void
@@ -709,6 +1070,107 @@ namespace gr {
 				  dataset_suffix);
     }
 
+    void
+    sigmf::parse_sax (metadata_handler& handler)
+    {
+      rapidjson::Reader reader;
+      sax_handler sax (handler, d_validation == VALIDATE_STRUCTURE);
+      rapidjson::ParseResult res;
+
+      if (d_validation == VALIDATE_SCHEMA) {
+	/* The validator sees every token before the handler, so the file
+	 * is only read once. It is bound to the handler and cannot come
+	 * from the per thread pool, but the schema does. */
+	typedef rapidjson::GenericSchemaValidator<rapidjson::SchemaDocument,
+	    sax_handler> forwarding_validator;
+	d_sd = &schema_cache::document ();
+	forwarding_validator validator (*d_sd, sax);
+	res = reader.Parse (*d_frs, validator);
+	if (res.IsError () && !sax.stopped ()
+	    && validator.GetInvalidSchemaKeyword ()) {
+	  throw_schema_error (d_metadata_filename, validator);
+	}
+      }
+      else {
+	res = reader.Parse (*d_frs, sax);
+      }
+
+      if (res.IsError () && !sax.stopped ()) {
+	if (!sax.error ().empty ()) {
+	  throw std::runtime_error (
+	      "sigmf: " + d_metadata_filename + ": " + sax.error ());
+	}
+	throw_parse_error (d_metadata_filename, res.Code (), res.Offset ());
+      }
+    }
+
+    void
+    sigmf::parse_dom (metadata_handler& handler)
+    {
+      rapidjson::Value::ConstMemberIterator itr;
+      rapidjson::Value::ConstValueIterator v;
+
+      /* The document goes before the memory it lives in */
+      delete d_doc;
+      d_doc = NULL;
+      if (d_arena) {
+	d_arena->clear ();
+      }
+      else {
+	d_arena = new arena (dom_chunk (d_fp));
+      }
+      d_doc = new rapidjson::Document (&d_arena->allocator ());
+      d_doc->ParseStream (*d_frs);
+      if (d_doc->HasParseError ()) {
+	throw_parse_error (d_metadata_filename, d_doc->GetParseError (),
+			   d_doc->GetErrorOffset ());
+      }
+      if (!d_doc->IsObject ()) {
+	throw std::runtime_error (
+	    "sigmf: " + d_metadata_filename + ": not a JSON object");
+      }
+
+      if (d_validation == VALIDATE_STRUCTURE) {
+	std::string error = check_structure (*d_doc);
+	if (!error.empty ()) {
+	  throw std::runtime_error (
+	      "sigmf: " + d_metadata_filename + ": " + error);
+	}
+      }
+      else if (d_validation == VALIDATE_SCHEMA) {
+	d_sd = &schema_cache::document ();
+	d_validator = &schema_cache::validator ();
+	if (!d_doc->Accept (*d_validator)) {
+	  throw_schema_error (d_metadata_filename, *d_validator);
+	}
+      }
+
+      itr = d_doc->FindMember ("global");
+      if (itr != d_doc->MemberEnd () && itr->value.IsObject ()) {
+	if (!handler.on_global (dom_global (itr->value))) {
+	  return;
+	}
+      }
+
+      itr = d_doc->FindMember ("captures");
+      if (itr != d_doc->MemberEnd () && itr->value.IsArray ()) {
+	for (v = itr->value.Begin (); v != itr->value.End (); ++v) {
+	  if (v->IsObject () && !handler.on_capture (dom_capture (*v))) {
+	    return;
+	  }
+	}
+      }
+
+      itr = d_doc->FindMember ("annotations");
+      if (itr != d_doc->MemberEnd () && itr->value.IsArray ()) {
+	for (v = itr->value.Begin (); v != itr->value.End (); ++v) {
+	  if (v->IsObject () && !handler.on_annotation (dom_annotation (*v))) {
+	    return;
+	  }
+	}
+      }
+    }
+
   } /* namespace sigmf */
 } /* namespace gr */
 
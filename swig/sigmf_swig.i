@@ -8,12 +8,43 @@
 %include "sigmf_swig_doc.i"
 
 %{
+#include "sigmf/string_ref.h"
+#include "sigmf/interned_string.h"
+#include "sigmf/arena.h"
 #include "sigmf/global.h"
 #include "sigmf/capture.h"
+#include "sigmf/capture_table.h"
 #include "sigmf/annotation.h"
+#include "sigmf/annotation_index.h"
+#include "sigmf/annotation_table.h"
+#include "sigmf/annotation_rtree.h"
+#include "sigmf/datatype.h"
+#include "sigmf/metadata_handler.h"
 #include "sigmf/sigmf.h"
+#include "sigmf/metadata_view.h"
+#include "sigmf/metadata_writer.h"
+#include "sigmf/source.h"
+#include "sigmf/sink.h"
+#include "sigmf/verifier.h"
 %}
+%include "sigmf/string_ref.h"
+%include "sigmf/interned_string.h"
+%include "sigmf/arena.h"
 %include "sigmf/global.h"
 %include "sigmf/capture.h"
+%include "sigmf/capture_table.h"
 %include "sigmf/annotation.h"
+%include "sigmf/annotation_index.h"
+%include "sigmf/annotation_table.h"
+%include "sigmf/annotation_rtree.h"
+%include "sigmf/datatype.h"
+%include "sigmf/metadata_handler.h"
 %include "sigmf/sigmf.h"
+%include "sigmf/metadata_view.h"
+%include "sigmf/metadata_writer.h"
+
+%include "sigmf/source.h"
+GR_SWIG_BLOCK_MAGIC2(sigmf, source);
+%include "sigmf/sink.h"
+GR_SWIG_BLOCK_MAGIC2(sigmf, sink);
+%include "sigmf/verifier.h"